@@ -816,7 +816,9 @@ static string make_filename
 (
 	uint_fast64_t max_n,
 	uint_fast64_t max_period_n,
-	uint_fast64_t not_escaped
+	uint_fast64_t not_escaped,
+	uint32_t image_width,
+	uint32_t image_height
 )
 {
 	std::ostringstream ss;
@@ -868,10 +870,10 @@ static string make_filename
 	{
 		ss << "_smooth";
 	}
-	ss << '_' << width_px << 'x';
-	if(width_px != height_px)
+	ss << '_' << image_width << 'x';
+	if(image_width != image_height)
 	{
-		ss << height_px;
+		ss << image_height;
 	}
 	if(color_opt.multiplier != 1)
 	{
@@ -913,7 +915,100 @@ static size_t print_progress(const size_t prev_spaces, const string& startString
 	return spaces;
 }
 
-static void createFractal()
+// box-filters finished rows of the full image into a smaller copy, so extra sizes need no second pass
+class Downsampler
+{
+public:
+	Downsampler(const uint32_t width, const uint32_t height)
+	:
+		image(width, height),
+		sums(width * 3),
+		counts(width),
+		row(0)
+	{
+	}
+
+	// pY must be fully rendered, and rows must be added in order
+	void add_row(const png::image<png::rgb_pixel>& source, const uint_fast32_t pY)
+	{
+		const uint32_t out_row = static_cast<uint32_t>(uint_fast64_t(pY) * image.get_height() / height_px);
+		if(out_row != row)
+		{
+			flush();
+			row = out_row;
+		}
+
+		const uint_fast64_t out_width = image.get_width();
+		for(uint_fast32_t pX = 0; pX < width_px; ++pX)
+		{
+			const size_t out_x = static_cast<size_t>(pX * out_width / width_px);
+			const png::rgb_pixel pixel = source.get_pixel(pX, pY);
+			sums[out_x * 3    ] += pixel.red;
+			sums[out_x * 3 + 1] += pixel.green;
+			sums[out_x * 3 + 2] += pixel.blue;
+			++counts[out_x];
+		}
+	}
+
+	// writes the row being accumulated; rows that were never reached stay black, like in the full image
+	void flush()
+	{
+		for(size_t x = 0; x < counts.size(); ++x)
+		{
+			const uint_fast64_t count = counts[x];
+			if(count == 0)
+			{
+				continue;
+			}
+			#define avg(i) static_cast<png::byte>((sums[x * 3 + i] + count / 2) / count)
+			image.set_pixel(static_cast<uint32_t>(x), row, png::rgb_pixel(avg(0), avg(1), avg(2)));
+			#undef avg
+		}
+		std::fill(sums.begin(), sums.end(), 0);
+		std::fill(counts.begin(), counts.end(), 0);
+	}
+
+	png::image<png::rgb_pixel> image;
+
+private:
+	std::vector<uint_fast64_t> sums; // r, g, b for each output column
+	std::vector<uint_fast64_t> counts;
+	uint32_t row;
+};
+
+// each size is an output height; the width keeps the aspect ratio from -wm
+static std::vector<uint32_t> parse_sizes(const string& list)
+{
+	std::vector<uint32_t> sizes;
+	std::istringstream ss(list);
+	string item;
+	while(std::getline(ss, item, ','))
+	{
+		if(item.empty())
+		{
+			continue;
+		}
+		unsigned long size;
+		try
+		{
+			size = std::stoul(item);
+		}
+		catch(const std::logic_error&)
+		{
+			throw std::runtime_error("Invalid output size: " + item);
+		}
+		if(size == 0 || size >= height_px)
+		{
+			throw std::runtime_error("output size must be in range [1, " + std::to_string(height_px - 1) + "], but is " + item);
+		}
+		sizes.emplace_back(static_cast<uint32_t>(size));
+	}
+	std::sort(sizes.begin(), sizes.end());
+	sizes.erase(std::unique(sizes.begin(), sizes.end()), sizes.end());
+	return sizes;
+}
+
+static void createFractal(const std::vector<uint32_t>& sizes)
 {
 	const kompleks_type width = (fractal_opt.rbound - fractal_opt.lbound);
 	const kompleks_type height = (fractal_opt.ubound - fractal_opt.bbound);
@@ -943,6 +1038,14 @@ static void createFractal()
 
 	png::image<png::rgb_pixel> image(width_px, height_px);
 
+	std::vector<Downsampler> downsamplers;
+	downsamplers.reserve(sizes.size());
+	for(const uint32_t size : sizes)
+	{
+		const auto width = static_cast<uint32_t>(std::round(static_cast<long double>(size) * width_px / height_px));
+		downsamplers.emplace_back(std::max(width, uint32_t(1)), size);
+	}
+
 	std::vector<kompleks> pCheck(pCheckN);
 	kompleks c;
 
@@ -1053,6 +1156,19 @@ static void createFractal()
 			}
 			++currentPoint;
 		}
+
+		for(Downsampler& downsampler : downsamplers)
+		{
+			downsampler.add_row(image, pY);
+		}
+		if(cancel) // pressed CTRL+C
+		{
+			break;
+		}
+	}
+	for(Downsampler& downsampler : downsamplers)
+	{
+		downsampler.flush();
 	}
 
 	const auto duration = std_clock::now() - time_start;
@@ -1060,7 +1176,7 @@ static void createFractal()
 
 	// the final line should be long enough to cover the status
 
-	const string filename = make_filename(max_n, max_period_n, not_escaped);
+	const string filename = make_filename(max_n, max_period_n, not_escaped, width_px, height_px);
 	std::cout << '\r' << startString;
 	std::cout << " done in " << duration_s << " second";
 	if(duration_s != 1)
@@ -1085,6 +1201,15 @@ static void createFractal()
 	std::cout << "Saving " << filename << "..." << std::flush;
 	image.write(filename);
 	std::cout << " done\n";
+
+	for(Downsampler& downsampler : downsamplers)
+	{
+		png::image<png::rgb_pixel>& small = downsampler.image;
+		const string small_filename = make_filename(max_n, max_period_n, not_escaped, small.get_width(), small.get_height());
+		std::cout << "Saving " << small_filename << "..." << std::flush;
+		small.write(small_filename);
+		std::cout << " done\n";
+	}
 }
 
 static void show_help()
@@ -1106,6 +1231,8 @@ static void show_help()
 	std::cout << " -cm        [f] Color multiplier\n";
 	std::cout << " -clog      [i] logarithm the colors\n";
 	std::cout << " -r         [i] Picture size (width and height)\n";
+	std::cout << " -sizes     [s] Comma-separated list of smaller sizes to also save,\n";
+	std::cout << "                 downsampled from the full picture (e.g. 256,1024)\n";
 	std::cout << " -i         [i] Maximum iterations for each point\n";
 	std::cout << " -e         [f] Exponent (default = 2); higher absolute value = slower\n";
 	std::cout << " -el        [f] Escape limit (default = 4)\n";
@@ -1172,6 +1299,7 @@ int main(const int argc, char** const argv)
 	argp.add("-jy"    ,    0.156L);
 	argp.add("-pc"    ,    1);
 	argp.add("-r"     , 1024);
+	argp.add("-sizes" , "");
 	argp.add("-t"     , "mandelbrot");
 	argp.add("-lbound",   -2.0L);
 	argp.add("-rbound",    2.0L);
@@ -1206,9 +1334,11 @@ int main(const int argc, char** const argv)
 	pCheckN                  = argp.get_uint("-pc");
 	height_px                = argp.get_uint("-r");
 	width_px                 = static_cast<uint32_t>(std::round(height_px * argp.get_lfloat("-wm")));
+	std::vector<uint32_t> sizes;
 	try
 	{
 		fractal_opt.type = string_to_fractal_type(argp.get_string("-t"));
+		sizes = parse_sizes(argp.get_string("-sizes"));
 	}
 	catch(std::runtime_error& e)
 	{
@@ -1247,7 +1377,7 @@ int main(const int argc, char** const argv)
 	};
 	signal(SIGINT, ctrl_c_handler);
 
-	createFractal();
+	createFractal(sizes);
 
 	return 0;
 }